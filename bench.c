@@ -0,0 +1,161 @@
+/**
+ * @file bench.c
+ * @brief Head-to-head benchmark of the RB tree and the B+-tree.
+ *
+ * For every corpus, all tokens are read into memory first, so the
+ * timings cover only the trees: inserting every token, looking every
+ * token up again, and writing the full in-order output. Both trees
+ * are cross-checked for identical counts before the row is printed.
+ *
+ * usage: bench [file ...]  (defaults to the corpora in data/)
+ */
+
+#include "rb_node.h"
+#include "bp_tree.h"
+#include "word_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *corpora[] = {
+    "data/1000words.txt", "data/alphabet.txt", "data/commonwords.txt",
+    "data/enable1.txt", "data/input01.txt", "data/input02.txt",
+    "data/ospd.txt", "data/stopwords.txt", "data/web2.txt",
+    "data/wordlist.txt", "data/words.shakespeare.txt", "data/words.txt",
+    "data/words5-knuth.txt"
+};
+
+static double
+ms_since(clock_t start) {
+    return 1000.0 * (clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Same traversal as writeInorder in main.c; RB_NULL is the node with no word. */
+static void
+rb_write(const struct rb_node *node, FILE *out) {
+    if (node->word == NULL) return;
+    rb_write(node->left, out);
+    fprintf(out, "%s: %d\n", node->word, node->count);
+    rb_write(node->right, out);
+}
+
+static int
+rb_height(const struct rb_node *node) {
+    if (node->word == NULL) return 0;
+    int l = rb_height(node->left), r = rb_height(node->right);
+    return 1 + (l > r ? l : r);
+}
+
+static void
+rb_free(struct rb_node *node) {
+    if (node->word == NULL) return;
+    rb_free(node->left);
+    rb_free(node->right);
+    free(node->word);
+    free(node);
+}
+
+static void
+bench(const char *filename, FILE *sink) {
+    char **words;
+    long n;
+    struct rb_node input = {NULL};
+    struct rb_node *rb;
+    struct bp_tree bp;
+    double rb_ins, rb_look, rb_scan, bp_ins, bp_look, bp_scan;
+    clock_t start;
+    long hits = 0;
+
+    n = wf_read(filename, &words);
+    if (n < 0) {
+        printf("%-28s (cannot open)\n", filename);
+        return;
+    }
+
+    rb = malloc(sizeof(struct rb_node));
+    rb->word = NULL;
+    start = clock();
+    for (long i = 0; i < n; i++) {
+        input.word = words[i];
+        rb_insert(rb, &input);
+    }
+    rb_ins = ms_since(start);
+    start = clock();
+    for (long i = 0; i < n; i++) {
+        input.word = words[i];
+        hits += rb_find(rb, &input)->count > 0;
+    }
+    rb_look = ms_since(start);
+    start = clock();
+    if (n > 0) rb_write(rb, sink);
+    rb_scan = ms_since(start);
+
+    bp_init(&bp);
+    start = clock();
+    for (long i = 0; i < n; i++) {
+        bp_insert(&bp, words[i]);
+    }
+    bp_ins = ms_since(start);
+    start = clock();
+    for (long i = 0; i < n; i++) {
+        hits += bp_find(&bp, words[i]) != NULL;
+    }
+    bp_look = ms_since(start);
+    start = clock();
+    bp_write_inorder(&bp, sink);
+    bp_scan = ms_since(start);
+
+    for (long i = 0; i < n; i++) {
+        input.word = words[i];
+        if (rb_find(rb, &input)->count != *bp_find(&bp, words[i])) {
+            printf("%-28s count mismatch on \"%s\"\n", filename, words[i]);
+            break;
+        }
+    }
+    if (hits != 2 * n) {
+        printf("%-28s %ld lookups missed\n", filename, 2 * n - hits);
+    }
+
+    printf("%-28s %8ld %8ld | %4d %8.2f %8.2f %7.2f | %4d %8.2f %8.2f %7.2f\n",
+           filename, n, bp.size,
+           n > 0 ? rb_height(rb) : 0, rb_ins, rb_look, rb_scan,
+           bp.height, bp_ins, bp_look, bp_scan);
+
+    if (n > 0) {
+        rb_free(rb);
+    } else {
+        free(rb);
+    }
+    bp_destroy(&bp);
+    wf_free(words, n);
+}
+
+int main(int argc, char *argv[]) {
+    FILE *sink = fopen("/dev/null", "w");
+    if (sink == NULL) {
+        puts("There was an error opening /dev/null. Exiting now.");
+        exit(1);
+    }
+
+    printf("B+-tree order %d, node size %zu bytes; times in ms\n",
+           BP_ORDER, sizeof(struct bp_node));
+    printf("%-28s %8s %8s | %-31s | %-31s\n", "", "", "",
+           "RB tree", "B+-tree");
+    printf("%-28s %8s %8s | %4s %8s %8s %7s | %4s %8s %8s %7s\n",
+           "corpus", "tokens", "unique",
+           "hgt", "insert", "find", "scan", "hgt", "insert", "find", "scan");
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            bench(argv[i], sink);
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++) {
+            bench(corpora[i], sink);
+        }
+    }
+
+    fclose(sink);
+    return 0;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file bp_tree.c
+ * @brief Implementation file for a B+-tree for counting words.
+ */
+
+#include "bp_tree.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct bp_node Node;
+
+/*
+ * Page-sized nodes start on a page, so one node never spans two
+ * pages; smaller nodes start on a cache line, so the prefix array
+ * is read in whole lines.
+ * */
+#define BP_ALIGN (BP_NODE_BYTES % 4096 == 0 ? 4096 : 64)
+
+/*
+ * Packs the first 8 bytes of a word big-endian into an integer,
+ * zero-padded past the terminator, so that comparing two prefixes
+ * as integers orders them the same way strcmp does.
+ * */
+static uint64_t
+bp_prefix(const char *word) {
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8 && word[i] != '\0'; i++) {
+        prefix |= (uint64_t) (unsigned char) word[i] << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+/*
+ * Compares a search key against slot i of a node. The word in the
+ * slot is only dereferenced when the prefixes tie and neither word
+ * ends within them.
+ * */
+static int
+bp_compare(const Node *node, int i, const char *word, uint64_t prefix) {
+    if (prefix != node->prefix[i]) {
+        return prefix < node->prefix[i] ? -1 : 1;
+    }
+    if ((prefix & 0xff) == 0) { // both words end within the prefix
+        return 0;
+    }
+    return strcmp(word + 8, node->keys[i] + 8);
+}
+
+/*
+ * Binary search within a node. Returns the index of the first key
+ * that is not less than the search key and sets *found if it is
+ * equal to it.
+ * */
+static int
+bp_search(const Node *node, const char *word, uint64_t prefix, int *found) {
+    int lo = 0, hi = node->nkeys;
+    *found = 0;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = bp_compare(node, mid, word, prefix);
+        if (cmp > 0) {
+            lo = mid + 1;
+        } else if (cmp < 0) {
+            hi = mid;
+        } else {
+            *found = 1;
+            return mid;
+        }
+    }
+    return lo;
+}
+
+/* Index of the child of an inner node that covers the search key. */
+static int
+bp_child_index(const Node *node, const char *word, uint64_t prefix) {
+    int found;
+    int i = bp_search(node, word, prefix, &found);
+    return found ? i + 1 : i;
+}
+
+static Node *
+bp_node_new(int is_leaf) {
+    size_t size = (BP_NODE_BYTES + BP_ALIGN - 1) / BP_ALIGN * BP_ALIGN;
+    Node *node = aligned_alloc(BP_ALIGN, size);
+    node->nkeys = 0;
+    node->is_leaf = (unsigned char) is_leaf;
+    if (is_leaf) {
+        node->u.leaf.next = NULL;
+    }
+    return node;
+}
+
+static char *
+bp_strdup(const char *word) {
+    char *copy = malloc(strlen(word) + 1);
+    strcpy(copy, word);
+    return copy;
+}
+
+/* Opens a gap at slot i of a leaf and fills it with a new word. */
+static void
+bp_leaf_put(Node *leaf, int i, const char *word, uint64_t prefix) {
+    int move = leaf->nkeys - i;
+    memmove(&leaf->prefix[i + 1], &leaf->prefix[i], move * sizeof(leaf->prefix[0]));
+    memmove(&leaf->keys[i + 1], &leaf->keys[i], move * sizeof(leaf->keys[0]));
+    memmove(&leaf->u.leaf.count[i + 1], &leaf->u.leaf.count[i], move * sizeof(leaf->u.leaf.count[0]));
+    leaf->prefix[i] = prefix;
+    leaf->keys[i] = bp_strdup(word);
+    leaf->u.leaf.count[i] = 1;
+    leaf->nkeys++;
+}
+
+/* Inserts separator key at slot i of an inner node, with right as the child after it. */
+static void
+bp_inner_put(Node *node, int i, char *key, uint64_t prefix, Node *right) {
+    int move = node->nkeys - i;
+    memmove(&node->prefix[i + 1], &node->prefix[i], move * sizeof(node->prefix[0]));
+    memmove(&node->keys[i + 1], &node->keys[i], move * sizeof(node->keys[0]));
+    memmove(&node->u.child[i + 2], &node->u.child[i + 1], move * sizeof(node->u.child[0]));
+    node->prefix[i] = prefix;
+    node->keys[i] = key;
+    node->u.child[i + 1] = right;
+    node->nkeys++;
+}
+
+/* Moves the upper half of a full leaf into a new leaf linked after it. */
+static Node *
+bp_leaf_split(Node *leaf) {
+    int half = BP_ORDER / 2;
+    int move = BP_ORDER - half;
+    Node *right = bp_node_new(1);
+    memcpy(right->prefix, &leaf->prefix[half], move * sizeof(leaf->prefix[0]));
+    memcpy(right->keys, &leaf->keys[half], move * sizeof(leaf->keys[0]));
+    memcpy(right->u.leaf.count, &leaf->u.leaf.count[half], move * sizeof(leaf->u.leaf.count[0]));
+    right->nkeys = (unsigned short) move;
+    leaf->nkeys = (unsigned short) half;
+    right->u.leaf.next = leaf->u.leaf.next;
+    leaf->u.leaf.next = right;
+    return right;
+}
+
+/*
+ * Splits a full inner node around its middle separator, which is
+ * handed back through *key and *prefix for the parent to own.
+ * */
+static Node *
+bp_inner_split(Node *node, char **key, uint64_t *prefix) {
+    int mid = BP_ORDER / 2;
+    int move = BP_ORDER - mid - 1;
+    Node *right = bp_node_new(0);
+    memcpy(right->prefix, &node->prefix[mid + 1], move * sizeof(node->prefix[0]));
+    memcpy(right->keys, &node->keys[mid + 1], move * sizeof(node->keys[0]));
+    memcpy(right->u.child, &node->u.child[mid + 1], (move + 1) * sizeof(node->u.child[0]));
+    right->nkeys = (unsigned short) move;
+    *key = node->keys[mid];
+    *prefix = node->prefix[mid];
+    node->nkeys = (unsigned short) mid;
+    return right;
+}
+
+/*
+ * Recursive insert. If @p node had to split, the new right sibling
+ * is returned through *split along with the separator the parent
+ * must insert in front of it.
+ * */
+static int
+bp_insert_node(Node *node, const char *word, uint64_t prefix,
+               Node **split, char **sep, uint64_t *sep_prefix) {
+    int found;
+    *split = NULL;
+
+    if (node->is_leaf) {
+        int i = bp_search(node, word, prefix, &found);
+        if (found) {
+            node->u.leaf.count[i] += 1;
+            return 0;
+        }
+        if (node->nkeys < BP_ORDER) {
+            bp_leaf_put(node, i, word, prefix);
+            return 1;
+        }
+        Node *right = bp_leaf_split(node);
+        if (i > node->nkeys) {
+            bp_leaf_put(right, i - node->nkeys, word, prefix);
+        } else {
+            bp_leaf_put(node, i, word, prefix);
+        }
+        *split = right;
+        *sep = bp_strdup(right->keys[0]);
+        *sep_prefix = right->prefix[0];
+        return 1;
+    }
+
+    int c = bp_child_index(node, word, prefix);
+    Node *child_split;
+    char *child_sep;
+    uint64_t child_prefix;
+    int inserted = bp_insert_node(node->u.child[c], word, prefix,
+                                  &child_split, &child_sep, &child_prefix);
+    if (child_split == NULL) {
+        return inserted;
+    }
+    if (node->nkeys < BP_ORDER) {
+        bp_inner_put(node, c, child_sep, child_prefix, child_split);
+        return inserted;
+    }
+    Node *right = bp_inner_split(node, sep, sep_prefix);
+    if (c <= node->nkeys) {
+        bp_inner_put(node, c, child_sep, child_prefix, child_split);
+    } else {
+        bp_inner_put(right, c - node->nkeys - 1, child_sep, child_prefix, child_split);
+    }
+    *split = right;
+    return inserted;
+}
+
+void
+bp_init(struct bp_tree *tree) {
+    tree->root = NULL;
+    tree->head = NULL;
+    tree->height = 0;
+    tree->size = 0;
+}
+
+int *
+bp_find(const struct bp_tree *tree, const char *word) {
+    const Node *node = tree->root;
+    uint64_t prefix = bp_prefix(word);
+    int found;
+
+    if (node == NULL) {
+        return NULL;
+    }
+    while (!node->is_leaf) {
+        node = node->u.child[bp_child_index(node, word, prefix)];
+    }
+    int i = bp_search(node, word, prefix, &found);
+    return found ? (int *) &node->u.leaf.count[i] : NULL;
+}
+
+int
+bp_insert(struct bp_tree *tree, const char *word) {
+    uint64_t prefix = bp_prefix(word);
+    Node *split;
+    char *sep;
+    uint64_t sep_prefix;
+
+    if (tree->root == NULL) {
+        tree->root = bp_node_new(1);
+        tree->head = tree->root;
+        tree->height = 1;
+    }
+    int inserted = bp_insert_node(tree->root, word, prefix, &split, &sep, &sep_prefix);
+    if (split != NULL) { // the root split, so the tree grows by one level
+        Node *root = bp_node_new(0);
+        root->u.child[0] = tree->root;
+        bp_inner_put(root, 0, sep, sep_prefix, split);
+        tree->root = root;
+        tree->height++;
+    }
+    tree->size += inserted;
+    return inserted;
+}
+
+int
+bp_delete(struct bp_tree *tree, const char *word) {
+    Node *node = tree->root;
+    uint64_t prefix = bp_prefix(word);
+    int found;
+
+    if (node == NULL) {
+        return 0;
+    }
+    while (!node->is_leaf) {
+        node = node->u.child[bp_child_index(node, word, prefix)];
+    }
+    int i = bp_search(node, word, prefix, &found);
+    if (!found) {
+        return 0;
+    }
+    free(node->keys[i]);
+    int move = node->nkeys - i - 1;
+    memmove(&node->prefix[i], &node->prefix[i + 1], move * sizeof(node->prefix[0]));
+    memmove(&node->keys[i], &node->keys[i + 1], move * sizeof(node->keys[0]));
+    memmove(&node->u.leaf.count[i], &node->u.leaf.count[i + 1], move * sizeof(node->u.leaf.count[0]));
+    node->nkeys--;
+    tree->size--;
+    return 1;
+}
+
+void
+bp_write_inorder(const struct bp_tree *tree, FILE *out) {
+    for (const Node *leaf = tree->head; leaf != NULL; leaf = leaf->u.leaf.next) {
+        for (int i = 0; i < leaf->nkeys; i++) {
+            fprintf(out, "%s: %d\n", leaf->keys[i], leaf->u.leaf.count[i]);
+        }
+    }
+}
+
+static void
+bp_free_node(Node *node) {
+    if (!node->is_leaf) {
+        for (int i = 0; i <= node->nkeys; i++) {
+            bp_free_node(node->u.child[i]);
+        }
+    }
+    for (int i = 0; i < node->nkeys; i++) {
+        free(node->keys[i]);
+    }
+    free(node);
+}
+
+void
+bp_destroy(struct bp_tree *tree) {
+    if (tree->root != NULL) {
+        bp_free_node(tree->root);
+    }
+    bp_init(tree);
+}
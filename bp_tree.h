@@ -0,0 +1,144 @@
+/**
+ * @file bp_tree.h
+ * @brief Header file (API) for a B+-tree for counting words.
+ *
+ * An alternative to the RB tree in rb_node.h with the same
+ * find/insert/delete/in-order operations. Each node holds up to
+ * BP_ORDER keys, so a lookup touches about log_BP_ORDER(n) nodes
+ * instead of the 2 log2(n) pointer hops of a binary tree. The
+ * first 8 bytes of every key are packed into a sorted integer
+ * array at the front of the node, so most comparisons never
+ * leave the node to dereference the word itself. Leaves are
+ * linked left to right for in-order output.
+ *
+ * Build with -DUSE_BPTREE to have main.c count words with it.
+ */
+
+#ifndef BP_TREE_H
+#define BP_TREE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * @brief Target size of a node in bytes.
+ *
+ * Defaults to a 4 KB page. Override at build time (e.g.
+ * -DBP_NODE_BYTES=256 for nodes of four cache lines).
+ */
+#ifndef BP_NODE_BYTES
+#define BP_NODE_BYTES 4096
+#endif
+
+/**
+ * @brief Maximum number of keys in a node.
+ *
+ * Each key costs a prefix, a word pointer and a child pointer;
+ * the remaining bytes cover the extra child and the header.
+ * This gives 170 keys for 4096 bytes and 10 for 256.
+ */
+#define BP_ORDER ((BP_NODE_BYTES - 16) / 24)
+
+/**
+ * @brief A B+-tree node, either inner or leaf.
+ *
+ * Inner nodes hold @c nkeys separators and @c nkeys + 1 children.
+ * Leaves hold the words with their counts and a link to the next
+ * leaf. The separators in inner nodes are private copies, so a
+ * word deleted from a leaf never leaves a dangling separator.
+ */
+struct bp_node {
+  uint64_t prefix[BP_ORDER];
+  char *keys[BP_ORDER];
+  union {
+    struct bp_node *child[BP_ORDER + 1];
+    struct {
+      int count[BP_ORDER];
+      struct bp_node *next;
+    } leaf;
+  } u;
+  unsigned short nkeys;
+  unsigned char is_leaf;
+};
+
+_Static_assert(BP_ORDER >= 3, "BP_NODE_BYTES is too small for a B+-tree node");
+_Static_assert(sizeof(struct bp_node) <= BP_NODE_BYTES,
+               "struct bp_node does not fit in BP_NODE_BYTES");
+
+/**
+ * @brief The B+-tree handle.
+ */
+struct bp_tree {
+  struct bp_node *root;
+  struct bp_node *head;
+  int height;
+  long size;
+};
+
+/**
+ * @brief Initializes an empty tree.
+ *
+ * @param tree The tree to initialize.
+ */
+void
+bp_init(struct bp_tree *tree);
+
+/**
+ * @brief Search for a word in the tree.
+ *
+ * @param tree The B+-tree in which to search.
+ * @param word The key to search for.
+ * @return A pointer to the word's count, or NULL if not found.
+ */
+int *
+bp_find(const struct bp_tree *tree, const char *word);
+
+/**
+ * @brief Inserts a word into the tree.
+ *
+ * If @p word is already in @p tree its count is incremented,
+ * otherwise a copy of it is inserted with a count of 1. Full
+ * nodes are split on the way back up.
+ *
+ * @param tree B+-tree in which to insert the word.
+ * @param word The word to insert.
+ * @return 1 if the word was new, 0 if duplicate.
+ */
+int
+bp_insert(struct bp_tree *tree, const char *word);
+
+/**
+ * @brief Delete a word from the tree.
+ *
+ * Removes @p word and its count from its leaf. Underfull nodes
+ * are not merged, so the tree never shrinks in height; routing
+ * stays correct because separators need not be present keys.
+ *
+ * @param tree B+-tree from which to attempt to delete.
+ * @param word The word to delete.
+ * @return 1 if the word was deleted, 0 if not found.
+ */
+int
+bp_delete(struct bp_tree *tree, const char *word);
+
+/**
+ * @brief Writes the tree to a file in alphabetical order.
+ *
+ * Walks the linked leaves and prints each word with its count,
+ * in the same format as the RB tree output.
+ *
+ * @param tree The B+-tree to print.
+ * @param out An output file.
+ */
+void
+bp_write_inorder(const struct bp_tree *tree, FILE *out);
+
+/**
+ * @brief Frees all nodes and words of the tree.
+ *
+ * @param tree The B+-tree to destroy. It is left empty.
+ */
+void
+bp_destroy(struct bp_tree *tree);
+
+#endif //BP_TREE_H
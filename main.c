@@ -1,17 +1,95 @@
 #include "test_suite.h"
 #include "rb_node.h"
+#include "bp_tree.h"
+#include "stopwords.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 
-#define MAX_WORD 32
+#define MAX_WORD 256 // must match the width in the fscanf below
 
 void writeInorder(struct rb_node *tree, FILE *out);
+void destroyTree(struct rb_node *tree);
+
+/*
+ * The tree that counts the words is chosen at build time.
+ * main only goes through the wrappers below, so both backends
+ * share the same ingest, delete and output path.
+ */
+#ifdef USE_BPTREE
+typedef struct bp_tree Tree;
+
+static void initTree(Tree *tree) {
+    bp_init(tree);
+}
+
+/* Returns 1 if the word was new, 0 if its count was incremented. */
+static int countWord(Tree *tree, char *word) {
+    return bp_insert(tree, word);
+}
+
+/* Returns 1 if the word was deleted, 0 if not found. */
+static int deleteWord(Tree *tree, char *word) {
+    return bp_delete(tree, word);
+}
+
+static void writeTree(Tree *tree, FILE *out) {
+    bp_write_inorder(tree, out);
+}
+
+static void freeTree(Tree *tree) {
+    bp_destroy(tree);
+}
+#else
+typedef struct rb_node *Tree;
+
+static void initTree(Tree *tree) {
+    //Tree tree  = {NULL}; /* this would be ok, except it can't be freed */
+    *tree = (struct rb_node *) malloc(sizeof(struct rb_node));
+    (*tree)->word = NULL;
+}
+
+/*
+ * Right now, input simply points to the word, which is
+ * the caller's buffer. A deep copy is performed on insert,
+ * so there is no need to allocate something that will only
+ * last for a single loop iteration.
+ */
+static int countWord(Tree *tree, char *word) {
+    struct rb_node input = {NULL};
+    input.word = word;
+    return rb_insert(*tree, &input) != NULL;
+}
+
+static int deleteWord(Tree *tree, char *word) {
+    struct rb_node input = {NULL};
+    input.word = word;
+    struct rb_node *deleted = rb_delete(*tree, &input);
+    if (deleted == NULL) {
+        return 0;
+    }
+    free(deleted->word);
+    free(deleted);
+    return 1;
+}
+
+static void writeTree(Tree *tree, FILE *out) {
+    writeInorder(*tree, out);
+}
+
+static void freeTree(Tree *tree) {
+    if ((*tree)->word == NULL) { // empty, so destroyTree won't free it
+        free(*tree);
+    } else {
+        destroyTree(*tree);
+    }
+}
+#endif
 
 int main(int argc, char *argv[]) {
     
-    if (argc != 2) {
-        puts("usage: hwk2 input_file");
+    if (argc != 2 && argc != 3) {
+        puts("usage: hwk2 input_file [stopword_file]");
         exit(1);
     }
     
@@ -28,56 +106,44 @@ int main(int argc, char *argv[]) {
         exit(1);
     }
     
-    typedef struct rb_node Tree, Node;
-    //Tree tree  = {NULL}; /* this would be ok, except it can't be freed */
-    Tree* tree = (Tree *) malloc(sizeof(Tree));
-    tree->word = NULL;
-    Node input = {NULL}; //Node* input = (Node *) malloc(sizeof(Node));
-    
     /*
-     * Right now, input simply points to buff, which
-     * is static. This may need to change if input->word
-     * must be freed. Otherwise, it is fine as it is
-     * since a deep copy on the buffer will be performed.
-     * I currently don't see a need to allocate something
-     * that will only last for a single loop iteration.
+     * Stopwords are filtered out before they reach the tree,
+     * instead of being inserted and deleted again afterwards.
+     * An empty set rejects nothing.
      */
-    while (fscanf(in, "%s", buff) != EOF) {
-        //input.word = (char *) malloc(sizeof(char) * strlen(buff) + 1);
-        //strcpy(input.word, buff); // would need to free this
-        input.word = buff;
-        rb_insert(tree, &input);
+    struct sw_set stopwords = {NULL};
+    if (argc == 3 && !sw_load(&stopwords, argv[2])) {
+        puts(argv[2]);
+        puts("\nThere was an error loading the stopwords. Exiting now.");
+        exit(1);
     }
+    long tokens = 0, filtered = 0, size = 0;
     
-    // Test rb_min
-    //struct rb_node *min = rb_min(&tree);
-    //printf("min : %s\n", min->word);
-    
-    // Test rb_find
-    /*
-    char *str_arr[5] = {"this", "is", "a", "pirate's", "sword"};
-    for (int i = 0; i < 5; i++) {
-        input.word = str_arr[i];
-        if (rb_find(&tree, &input)->word == NULL) {
-            printf("\"%s\" was not found in the file.\n", str_arr[i]);
-        } else {
-            printf("\"%s\" was found in the file.\n", str_arr[i]);
+    Tree tree;
+    initTree(&tree);
+    while (fscanf(in, "%255s", buff) != EOF) {
+        tokens++;
+        if (sw_contains(&stopwords, buff)) {
+            filtered++;
+            continue;
         }
-    } */
+        size += countWord(&tree, buff);
+    }
     
-    input.word = "ho"; // doesn't work for root: "yo"
-    //printf("root before %p:%s\n", tree, tree->word);
-    rb_delete(tree, &input);
-    //printf("root after %p:%s\n", tree, tree->word);
+    size -= deleteWord(&tree, "ho");
     
     // Inserting into a tree automatically sorts, so now we can print.
     FILE *out = fopen("./program_output.txt", "w");
-    writeInorder(tree, out);
+    writeTree(&tree, out);
+    
+    printf("Read %ld words, filtered %ld stopwords (%.1f%%), %ld words in the tree.\n",
+           tokens, filtered, tokens > 0 ? 100.0 * filtered / tokens : 0.0, size);
     
     // Cleanup
+    sw_destroy(&stopwords);
     fclose(in);
     fclose(out);
-    //destroy(tree);
+    freeTree(&tree);
     puts("The program has finished executing.");
     exit(0);
     //*/
@@ -99,4 +165,16 @@ void writeInorder(struct rb_node *node, FILE *out) {
     writeInorder(node->left, out);
     fprintf(out, "%s: %d\n", node->word, node->count);
     writeInorder(node->right, out);
-}
\ No newline at end of file
+}
+/**
+ * @brief Frees a tree, its nodes and their words.
+ *
+ * @param node The RB tree to free.
+ */
+void destroyTree(struct rb_node *node) {
+    if (node->word == NULL) return;
+    destroyTree(node->left);
+    destroyTree(node->right);
+    free(node->word);
+    free(node);
+}
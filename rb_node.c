@@ -16,6 +16,35 @@ typedef struct rb_node Tree;
 /* Static sentinel structure for root and leaves cuts the required storage in half. */
 static struct rb_node RB_NULL; // members statically initialized to zero, so color is RB_BLACK
 
+unsigned long rb_compare_count;
+
+/* Compares two keys, counting the comparison in rb_compare_count. */
+static int
+rb_compare(const char *a, const char *b) {
+    rb_compare_count++;
+    return strcmp(a, b);
+}
+
+/* Exchanges the key and count of two nodes, leaving colors and links alone. */
+static void
+rb_swap_key(struct rb_node *a, struct rb_node *b) {
+    char *word = a->word;
+    int count = a->count;
+    a->word  = b->word;
+    a->count = b->count;
+    b->word  = word;
+    b->count = count;
+}
+
+/* Exchanges the key, count and color of two nodes, leaving the links alone. */
+static void
+rb_swap_payload(struct rb_node *a, struct rb_node *b) {
+    unsigned char color = a->color;
+    rb_swap_key(a, b);
+    a->color = b->color;
+    b->color = color;
+}
+
 /**
  * @brief Search for a node in the tree.
  *
@@ -29,18 +58,23 @@ static struct rb_node RB_NULL; // members statically initialized to zero, so col
  * @param tree The RB tree in which to search.
  * @param node A dummy node, containing the key to search for.
  * @return A pointer to the node with that key, or NULL.
- * @note This function assumes that keys are unique.
+ * @note This function assumes that keys are unique. The result
+ * is only valid until the next rb_insert or rb_delete.
  */
 struct rb_node *
 rb_find(const struct rb_node *tree, const struct rb_node *node) {
     
-    if (strcmp(node->word, tree->word) < 0) {
+    if (tree->word == NULL) { // empty tree
+        return &RB_NULL;
+    }
+    int cmp = rb_compare(node->word, tree->word);
+    if (cmp < 0) {
         if (tree->left == &RB_NULL) { // NOT FOUND
             return &RB_NULL;
         } else { // continue left
             return rb_find(tree->left, node);
         }
-    } else if (strcmp(node->word, tree->word) > 0) {
+    } else if (cmp > 0) {
         if (tree->right == &RB_NULL) { // NOT FOUND
             return &RB_NULL;
         } else { // continue right
@@ -79,10 +113,37 @@ rb_left_rotate(struct rb_node *tree, struct rb_node *x) {
      https://www.geeksforgeeks.org/avl-tree-set-1-insertion/
      * */
     
-    // parameter "tree" is not used and I don't know why it is included
+    /*
+     * The root is owned by the caller and its address never changes,
+     * so rotating at the root swaps payloads with y instead of
+     * relinking: x keeps its place at the top and y moves down.
+     */
     struct rb_node *y = x->right;
-    y->parent = x->parent;
+    if (x->parent == &RB_NULL) {
+        struct rb_node *t1 = x->left, *t2 = y->left, *t3 = y->right;
+        rb_swap_payload(x, y);
+        x->left   = y;
+        x->right  = t3;
+        y->left   = t1;
+        y->right  = t2;
+        y->parent = x;
+        /*
+         * t1 and t3 may both be RB_NULL. The sentinel's parent must
+         * end up at t1's new parent, because rb_restore_after_delete
+         * reads it when the sentinel is the left orphan.
+         * */
+        t3->parent = x;
+        t1->parent = y;
+        return;
+    }
     x->right = y->left;
+    if (y->left != &RB_NULL) y->left->parent = x;
+    y->parent = x->parent;
+    if (x == x->parent->left) {
+        x->parent->left = y;
+    } else {
+        x->parent->right = y;
+    }
     y->left = x;
     x->parent = y;
 }
@@ -116,10 +177,28 @@ rb_right_rotate(struct rb_node *tree, struct rb_node *y) {
      https://www.geeksforgeeks.org/avl-tree-set-1-insertion/
      * */
     
-    // parameter "tree" is not used and I don't know why it is included
+    /* mirror image of rb_left_rotate, including the root case */
     struct rb_node *x = y->left;
-    x->parent = y->parent;
+    if (y->parent == &RB_NULL) {
+        struct rb_node *t1 = x->left, *t2 = x->right, *t3 = y->right;
+        rb_swap_payload(y, x);
+        y->left   = t1;
+        y->right  = x;
+        x->left   = t2;
+        x->right  = t3;
+        x->parent = y;
+        t1->parent = y; // t3 last, for an orphaned RB_NULL on the right
+        t3->parent = x;
+        return;
+    }
     y->left = x->right;
+    if (x->right != &RB_NULL) x->right->parent = y;
+    x->parent = y->parent;
+    if (y == y->parent->left) {
+        y->parent->left = x;
+    } else {
+        y->parent->right = x;
+    }
     x->right = y;
     y->parent = x;
 }
@@ -133,8 +212,11 @@ rb_right_rotate(struct rb_node *tree, struct rb_node *y) {
  * If the insert is successful, the new node is colored <b>red</b>.
  *
  * @param tree RB tree in which to insert the new node.
- * @param node
- * @return A pointer to the inserted node, or NULL, if duplicate.
+ * @param node A dummy node, containing the key to insert.
+ * @return A pointer to the node holding the new key, or NULL, if duplicate.
+ * @note Rotations at the root move keys between nodes, so the
+ * result of rb_find or rb_insert may hold a different key after
+ * the next rb_insert or rb_delete.
  */
 //  Should the item simply be linked?
 //  Pros:
@@ -152,8 +234,13 @@ rb_right_rotate(struct rb_node *tree, struct rb_node *y) {
 //  TODO add parent nodes
 //  const struct must be cast to a non-const
 //  DEBUG print node: printf("NODE %p:%s\n", node, node->word);
-struct rb_node *
-rb_insert(struct rb_node *node, struct rb_node *item) {
+/*
+ * Recursive descent for rb_insert. Links a new red node under
+ * the first RB_NULL leaf on the search path and returns it, or
+ * bumps the count and returns NULL if the word is already present.
+ * */
+static struct rb_node *
+rb_insert_node(struct rb_node *node, struct rb_node *item) {
     
     /* ROOT CASE
      * node->word == NULL means node is the root
@@ -170,6 +257,7 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
         node->left   = &RB_NULL;
         node->right  = &RB_NULL;
         node->parent = &RB_NULL;
+        node->color  = RB_BLACK;
         return node;
     }
     
@@ -181,7 +269,8 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
      * case 3: word == node-> word
      *		the key is equal to the key of the current node
      * */
-    if (strcmp(item->word, node->word) < 0) {
+    int cmp = rb_compare(item->word, node->word);
+    if (cmp < 0) {
         
         /*
          * If there is immediate room on the left, place a node.
@@ -197,8 +286,10 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
             tmp->word = (char*) malloc(sizeof(char) * (strlen(item->word) + 1));
             strcpy(tmp->word, item->word);
             tmp->count = 1;
+            tmp->color = RB_RED;
             node->left = tmp;
             tmp->parent = node;
+            return tmp;
             
             /*
              * ((Node *) node)->left = item;
@@ -213,9 +304,9 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
              */
             
         } else {
-            rb_insert(node->left, item);
+            return rb_insert_node(node->left, item);
         }
-    } else if (strcmp(item->word, node->word) > 0) {
+    } else if (cmp > 0) {
         
         /*
          * If there is immediate room on the right, place a node.
@@ -231,19 +322,32 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
             tmp->word = (char*) malloc(sizeof(char) * (strlen(item->word) + 1));
             strcpy(tmp->word, item->word);
             tmp->count = 1;
+            tmp->color = RB_RED;
             node->right = tmp;
             tmp->parent = node;
+            return tmp;
             
         } else {
-            rb_insert(node->right, item);
+            return rb_insert_node(node->right, item);
         }
     } else { /* found the same word */
         node->count += 1;
     }
-    
-    //TODO call fixup method and set color to red
-    
-    return node;
+    return NULL;
+}
+
+struct rb_node *
+rb_insert(struct rb_node *tree, struct rb_node *node) {
+    struct rb_node *inserted = rb_insert_node(tree, node);
+    if (inserted != NULL && inserted != tree) {
+        char *word = inserted->word;
+        rb_restore_after_insert(tree, inserted);
+        /* a rotation at the root may have swapped the new key up into it */
+        if (inserted->word != word) {
+            inserted = tree;
+        }
+    }
+    return inserted;
 }
 
 /**
@@ -260,7 +364,57 @@ rb_insert(struct rb_node *node, struct rb_node *item) {
  */
 void
 rb_restore_after_insert(struct rb_node *tree, struct rb_node *node) {
-
+    
+    /*
+     * Only a red node under a red parent violates the properties.
+     * The parent is then never the root, so the grandparent exists.
+     * case 1: red uncle
+     *      recolor and move the violation two levels up
+     * case 2: black uncle, node is an inner grandchild
+     *      rotate at the parent to turn it into case 3
+     * case 3: black uncle, node is an outer grandchild
+     *      recolor and rotate at the grandparent, which ends the loop
+     * */
+    while (node->parent->color == RB_RED) {
+        struct rb_node *parent = node->parent;
+        struct rb_node *grand = parent->parent;
+        if (parent == grand->left) {
+            struct rb_node *uncle = grand->right;
+            if (uncle->color == RB_RED) {
+                parent->color = RB_BLACK;
+                uncle->color = RB_BLACK;
+                grand->color = RB_RED;
+                node = grand;
+                continue;
+            }
+            if (node == parent->right) {
+                node = parent;
+                rb_left_rotate(tree, node);
+                parent = node->parent;
+            }
+            parent->color = RB_BLACK;
+            grand->color = RB_RED;
+            rb_right_rotate(tree, grand);
+        } else {
+            struct rb_node *uncle = grand->left;
+            if (uncle->color == RB_RED) {
+                parent->color = RB_BLACK;
+                uncle->color = RB_BLACK;
+                grand->color = RB_RED;
+                node = grand;
+                continue;
+            }
+            if (node == parent->left) {
+                node = parent;
+                rb_right_rotate(tree, node);
+                parent = node->parent;
+            }
+            parent->color = RB_BLACK;
+            grand->color = RB_RED;
+            rb_left_rotate(tree, grand);
+        }
+    }
+    tree->color = RB_BLACK;
 }
 
 /**
@@ -306,7 +460,17 @@ rb_min(struct rb_node *tree) {
  */
 void
 rb_transplant(struct rb_node *tree, struct rb_node *old_root, struct rb_node *new_root) {
-
+    
+    /* the root node belongs to the caller and is never replaced */
+    if (old_root == tree) {
+        return;
+    }
+    if (old_root == old_root->parent->left) {
+        old_root->parent->left = new_root;
+    } else {
+        old_root->parent->right = new_root;
+    }
+    new_root->parent = old_root->parent; // also when new_root is RB_NULL
 }
 
 /**
@@ -320,55 +484,59 @@ rb_transplant(struct rb_node *tree, struct rb_node *old_root, struct rb_node *ne
  * @return A pointer to the deleted node, or NULL, if not found.
  * @note The caller is responsible for freeing the deleted node.
  */
-// TODO maintain parent info
-// TODO make sure tree->word is freed
-// IMPORTANT:
-//  rb_delete works to delete everything EXCEPT for the head
-//  node. The head cannot be deleted because the address is
-//  passed by value. I could fix this if I passed a pointer
-//  to the pointer, but I shouldn't change the API.
-//  If I can differentiate between the other nodes and the root
-//  pointer, maybe I can invoke the rb_delete method again to try
-//  to change it indirectly.
+//  The root node belongs to the caller and cannot be unlinked,
+//  so when the key to delete sits in the root, it is swapped into
+//  another node and that node is returned instead.
 struct rb_node *
 rb_delete(struct rb_node *tree, struct rb_node *node) {
     
-    if (tree == &RB_NULL) {
-        return &RB_NULL;
-    } else if (strcmp(node->word, tree->word) < 0) {
-        tree->left = rb_delete(tree->left, node);
-    } else if (strcmp(node->word, tree->word) > 0) {
-        tree->right = rb_delete(tree->right, node);
-    } else { // The node to delete is found
-        
-        /* DETECT ROOT */
-        //if (tree->parent == &RB_NULL) rb_delete(tree, &RB_NULL);
-        
-        if (tree->left == &RB_NULL && tree->right == &RB_NULL) { // no children
-            free(tree);
-            tree = &RB_NULL;
-        } else if (tree->left == &RB_NULL) { // one child
-            struct rb_node *tmp = tree;
-            tree = tree->right;
-            free(tmp);
-        } else if (tree->right == &RB_NULL) { // one child
-            struct rb_node *tmp = tree;
-            tree = tree->left;
-            free(tmp);
-        } else { //both children
-            // FROM THE SOURCE I LOOKED AT, tmp->word WOULD HAVE BEEN A CONST REFERENCE
-            // I DO NOT CURRENTLY KNOW IF A DEEP COPY IS NEEDED
-            struct rb_node *tmp = rb_min(tree->right);
-            tree->word = tmp->word;
-            tree->count = tmp->count;
-            tree->right = rb_delete(tree->right, tmp);
-            /*
-            Node* tmp = min(node->right);
-            node->data = tmp->data;
-            node->right = removeNode(node->right, tmp->data); */
+    struct rb_node *target = rb_find(tree, node);
+    if (target == &RB_NULL) {
+        return NULL;
+    }
+    
+    /*
+     * With two children, trade keys with the successor, which has
+     * no left child, and unlink that node instead.
+     * */
+    if (target->left != &RB_NULL && target->right != &RB_NULL) {
+        struct rb_node *successor = rb_min(target->right);
+        rb_swap_key(target, successor);
+        target = successor;
+    }
+    struct rb_node *orphan = target->left != &RB_NULL ? target->left : target->right;
+    
+    if (target == tree) {
+        /*
+         * A root with at most one child. That child must be a red
+         * leaf, so its key moves up and the child is removed. With
+         * no child the tree becomes empty and a fresh node carries
+         * the deleted key out.
+         * */
+        struct rb_node *removed = orphan;
+        if (removed == &RB_NULL) {
+            removed = malloc(sizeof(struct rb_node));
+            removed->word = NULL;
+            removed->count = 0;
         }
+        rb_swap_key(tree, removed);
+        tree->left  = &RB_NULL;
+        tree->right = &RB_NULL;
+        removed->parent = &RB_NULL;
+        removed->left   = &RB_NULL;
+        removed->right  = &RB_NULL;
+        removed->color  = RB_BLACK;
+        return removed;
+    }
+    
+    rb_transplant(tree, target, orphan);
+    if (target->color == RB_BLACK) {
+        rb_restore_after_delete(tree, orphan);
     }
-    return tree;
+    target->parent = &RB_NULL;
+    target->left   = &RB_NULL;
+    target->right  = &RB_NULL;
+    return target;
 }
 
 /**
@@ -383,5 +551,72 @@ rb_delete(struct rb_node *tree, struct rb_node *node) {
  */
 void
 rb_restore_after_delete(struct rb_node *tree, struct rb_node *orphan) {
-
+    
+    /*
+     * The orphan carries an extra black. Push it up until it lands
+     * on a red node or the root.
+     * case 1: red sibling
+     *      rotate at the parent to get a black sibling
+     * case 2: black sibling with two black children
+     *      color the sibling red and move the extra black up
+     * case 3: black sibling, near child red, far child black
+     *      rotate at the sibling to turn it into case 4
+     * case 4: black sibling with a red far child
+     *      recolor and rotate at the parent, which ends the loop
+     * */
+    while (orphan != tree && orphan->color == RB_BLACK) {
+        struct rb_node *parent = orphan->parent;
+        if (orphan == parent->left) {
+            struct rb_node *sibling = parent->right;
+            if (sibling->color == RB_RED) {
+                sibling->color = RB_BLACK;
+                parent->color = RB_RED;
+                rb_left_rotate(tree, parent);
+                parent = orphan->parent;
+                sibling = parent->right;
+            }
+            if (sibling->left->color == RB_BLACK && sibling->right->color == RB_BLACK) {
+                sibling->color = RB_RED;
+                orphan = parent;
+                continue;
+            }
+            if (sibling->right->color == RB_BLACK) {
+                sibling->left->color = RB_BLACK;
+                sibling->color = RB_RED;
+                rb_right_rotate(tree, sibling);
+                sibling = parent->right;
+            }
+            sibling->color = parent->color;
+            parent->color = RB_BLACK;
+            sibling->right->color = RB_BLACK;
+            rb_left_rotate(tree, parent);
+            orphan = tree;
+        } else {
+            struct rb_node *sibling = parent->left;
+            if (sibling->color == RB_RED) {
+                sibling->color = RB_BLACK;
+                parent->color = RB_RED;
+                rb_right_rotate(tree, parent);
+                parent = orphan->parent;
+                sibling = parent->left;
+            }
+            if (sibling->left->color == RB_BLACK && sibling->right->color == RB_BLACK) {
+                sibling->color = RB_RED;
+                orphan = parent;
+                continue;
+            }
+            if (sibling->left->color == RB_BLACK) {
+                sibling->right->color = RB_BLACK;
+                sibling->color = RB_RED;
+                rb_left_rotate(tree, sibling);
+                sibling = parent->left;
+            }
+            sibling->color = parent->color;
+            parent->color = RB_BLACK;
+            sibling->left->color = RB_BLACK;
+            rb_right_rotate(tree, parent);
+            orphan = tree;
+        }
+    }
+    orphan->color = RB_BLACK;
 }
\ No newline at end of file
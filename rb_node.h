@@ -28,6 +28,15 @@ struct rb_node {
   unsigned char color;
 };
 
+/**
+ * @brief Number of key comparisons made so far.
+ *
+ * Incremented by every key comparison in rb_find and rb_insert
+ * (and so rb_delete). The test suite reads it to check that each
+ * operation stays within the height bound of a balanced tree.
+ */
+extern unsigned long rb_compare_count;
+
 /**
  * @brief Search for a node in the tree.
  *
@@ -41,7 +50,8 @@ struct rb_node {
  * @param tree The RB tree in which to search.
  * @param node A dummy node, containing the key to search for.
  * @return A pointer to the node with that key, or NULL.
- * @note This function assumes that keys are unique.
+ * @note This function assumes that keys are unique. The result
+ * is only valid until the next rb_insert or rb_delete.
  */
 struct rb_node *
 rb_find(const struct rb_node *tree, const struct rb_node *node);
@@ -93,8 +103,11 @@ rb_right_rotate(struct rb_node *tree, struct rb_node *node);
  * If the insert is successful, the new node is colored <b>red</b>.
  *
  * @param tree RB tree in which to insert the new node.
- * @param node
- * @return A pointer to the inserted node, or NULL, if duplicate.
+ * @param node A dummy node, containing the key to insert.
+ * @return A pointer to the node holding the new key, or NULL, if duplicate.
+ * @note Rotations at the root move keys between nodes, so the
+ * result of rb_find or rb_insert may hold a different key after
+ * the next rb_insert or rb_delete.
  */
 struct rb_node *
 rb_insert(struct rb_node *tree, struct rb_node *node);
@@ -153,7 +166,9 @@ rb_transplant(struct rb_node *tree, struct rb_node *old_root, struct rb_node *ne
  * @param tree RB tree from which to attempt to delete.
  * @param node Node to be deleted.
  * @return A pointer to the deleted node, or NULL, if not found.
- * @note The caller is responsible for freeing the deleted node.
+ * @note The caller is responsible for freeing the deleted node
+ * and its word. The returned node holds the deleted key, but it
+ * need not be the node that held it in the tree.
  */
 struct rb_node *
 rb_delete(struct rb_node *tree, struct rb_node *node);
@@ -177,12 +192,12 @@ rb_restore_after_delete(struct rb_node *tree, struct rb_node *orphan);
 // TODO
 /*
 node rb_find                    complete
-void rb_left_rotate
-void rb_right_rotate
-node rb_insert
-void rb_restore_after_insert
-node rb_min
-void rb_transplant
-node rb_delete
-void rb_restore_after_delete
+void rb_left_rotate             complete
+void rb_right_rotate            complete
+node rb_insert                  complete
+void rb_restore_after_insert    complete
+node rb_min                     complete
+void rb_transplant              complete
+node rb_delete                  complete
+void rb_restore_after_delete    complete
 */
\ No newline at end of file
@@ -0,0 +1,31 @@
+/**
+ * @file run_tests.c
+ * @brief Runs the RB tree test suite on a set of corpora.
+ *
+ * usage: run_tests [file ...]  (defaults to a sample of data/)
+ */
+
+#include "test_suite.h"
+#include <stdio.h>
+
+static const char *corpora[] = {
+    "data/input02.txt", "data/1000words.txt", "data/words.txt",
+    "data/words.shakespeare.txt", "data/ospd.txt"
+};
+
+int main(int argc, char *argv[]) {
+    int failures = 0;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; i++) {
+            failures += ts_run_corpus(argv[i]);
+        }
+    } else {
+        for (size_t i = 0; i < sizeof(corpora) / sizeof(corpora[0]); i++) {
+            failures += ts_run_corpus(corpora[i]);
+        }
+    }
+
+    printf("%d failure%s\n", failures, failures == 1 ? "" : "s");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file stopwords.c
+ * @brief Implementation file for a static stopword filter.
+ */
+
+#include "stopwords.h"
+#include "word_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Seeds tried per table size before the table is doubled. */
+#define SW_SEEDS 64
+
+/*
+ * Seeded FNV-1a over at most SW_KEY bytes. Stores the word's length
+ * in *len, or SW_KEY if the word is too long to be in the table.
+ * */
+static uint64_t
+sw_hash(const char *word, uint64_t seed, size_t *len) {
+    uint64_t h = 14695981039346656037ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+    size_t i;
+    for (i = 0; i < SW_KEY && word[i] != '\0'; i++) {
+        h ^= (unsigned char) word[i];
+        h *= 1099511628211ULL;
+    }
+    *len = i;
+    return h ^ (h >> 29);
+}
+
+/*
+ * Places every word into buckets for the given size and seed.
+ * Returns 0 as soon as a bucket would overflow.
+ * */
+static int
+sw_build(struct sw_set *set, char **words, size_t n, size_t nbuckets, uint64_t seed) {
+    size_t len;
+    set->mask = nbuckets - 1;
+    set->seed = seed;
+    set->size = 0;
+    memset(set->buckets, 0, nbuckets * sizeof(struct sw_bucket));
+    for (size_t i = 0; i < n; i++) {
+        struct sw_bucket *b = &set->buckets[sw_hash(words[i], seed, &len) & set->mask];
+        int slot = 0;
+        while (slot < SW_SLOTS && b->word[slot][0] != '\0'
+               && strcmp(b->word[slot], words[i]) != 0) {
+            slot++;
+        }
+        if (slot == SW_SLOTS) {
+            return 0;
+        }
+        if (b->word[slot][0] == '\0') {
+            memcpy(b->word[slot], words[i], len);
+            set->size++;
+        }
+    }
+    return 1;
+}
+
+int
+sw_load(struct sw_set *set, const char *filename) {
+    char **words;
+    size_t nbuckets = 1;
+    int ok = 1;
+
+    set->buckets = NULL;
+    set->mask = 0;
+    set->seed = 0;
+    set->size = 0;
+
+    long count = wf_read(filename, &words);
+    if (count < 0) {
+        return 0;
+    }
+    size_t n = (size_t) count;
+    for (size_t i = 0; i < n; i++) {
+        if (strlen(words[i]) >= SW_KEY) {
+            ok = 0;
+        }
+    }
+
+    /* Start at about two words per bucket and grow until a seed fits. */
+    while (ok && nbuckets * 2 < n) {
+        nbuckets *= 2;
+    }
+    while (ok) {
+        set->buckets = aligned_alloc(64, nbuckets * sizeof(struct sw_bucket));
+        uint64_t seed;
+        for (seed = 0; seed < SW_SEEDS; seed++) {
+            if (sw_build(set, words, n, nbuckets, seed)) break;
+        }
+        if (seed < SW_SEEDS) break;
+        free(set->buckets);
+        nbuckets *= 2;
+    }
+
+    wf_free(words, count);
+    if (!ok) {
+        set->buckets = NULL;
+    }
+    return ok;
+}
+
+int
+sw_contains(const struct sw_set *set, const char *word) {
+    char key[SW_KEY] = {0};
+    size_t len;
+
+    if (set->buckets == NULL) {
+        return 0;
+    }
+    uint64_t h = sw_hash(word, set->seed, &len);
+    if (len == 0 || len == SW_KEY) {
+        return 0;
+    }
+    memcpy(key, word, len);
+    const struct sw_bucket *b = &set->buckets[h & set->mask];
+    for (int slot = 0; slot < SW_SLOTS; slot++) {
+        if (memcmp(b->word[slot], key, SW_KEY) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void
+sw_destroy(struct sw_set *set) {
+    free(set->buckets);
+    set->buckets = NULL;
+    set->mask = 0;
+    set->size = 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file stopwords.h
+ * @brief Header file (API) for a static stopword filter.
+ *
+ * The stopwords are read once into a hash table whose buckets are
+ * single cache lines holding up to SW_SLOTS words inline. The hash
+ * seed and table size are searched at load time until no bucket
+ * overflows, so a lookup hashes the word and compares it against
+ * one cache line, with no chaining and no pointers to follow.
+ */
+
+#ifndef STOPWORDS_H
+#define STOPWORDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Bytes per stored word, including the terminating NUL.
+ */
+#define SW_KEY 16
+
+/**
+ * @brief Words per bucket. A bucket is SW_SLOTS * SW_KEY = 64 bytes.
+ */
+#define SW_SLOTS 4
+
+/**
+ * @brief A bucket of the stopword table, aligned to a cache line.
+ *
+ * Unused slots are all zero, since the empty word is never looked up.
+ */
+struct sw_bucket {
+  _Alignas(64) char word[SW_SLOTS][SW_KEY];
+};
+
+/**
+ * @brief The stopword set.
+ */
+struct sw_set {
+  struct sw_bucket *buckets;
+  size_t mask;
+  uint64_t seed;
+  size_t size;
+};
+
+/**
+ * @brief Builds the set from a file of stopwords.
+ *
+ * Reads whitespace-separated words from @p filename. Duplicates
+ * are stored once. Fails if the file cannot be opened or if a
+ * stopword does not fit in SW_KEY - 1 characters.
+ *
+ * @param set The set to build.
+ * @param filename Path of the stopword file.
+ * @return 1 on success, 0 on failure, in which case @p set is empty.
+ */
+int
+sw_load(struct sw_set *set, const char *filename);
+
+/**
+ * @brief Checks whether a word is a stopword.
+ *
+ * @param set The stopword set.
+ * @param word The word to check.
+ * @return 1 if @p word is in @p set, 0 otherwise.
+ */
+int
+sw_contains(const struct sw_set *set, const char *word);
+
+/**
+ * @brief Frees the table of the set.
+ *
+ * @param set The set to destroy. It is left empty.
+ */
+void
+sw_destroy(struct sw_set *set);
+
+#endif //STOPWORDS_H
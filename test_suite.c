@@ -1,3 +1,318 @@
 #include "test_suite.h"
+#include "word_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
+/* Prints a violation and counts it. */
+#define TS_FAIL(failures, ...) do { \
+    printf("  FAIL: "); \
+    printf(__VA_ARGS__); \
+    printf("\n"); \
+    (failures)++; \
+} while (0)
 
+int
+ts_height_bound(long size) {
+    /* h <= 2 log2(n + 1)  <=>  2^h <= (n + 1)^2 */
+    unsigned long long limit = (unsigned long long) (size + 1) * (size + 1);
+    int h = 0;
+    while (h < 63 && (1ULL << (h + 1)) <= limit) {
+        h++;
+    }
+    return h;
+}
+
+/*
+ * Walks the subtree under node in order. Returns its black height
+ * (RB_NULL counts as 1) and adds its size and violations to the
+ * totals. RB_NULL is recognized by its NULL word.
+ * */
+static int
+ts_check_node(const struct rb_node *node, const struct rb_node *parent, int depth,
+              const char **prev, long *size, int *height, int *failures) {
+    if (node->word == NULL) {
+        if (node->color != RB_BLACK) {
+            TS_FAIL(*failures, "RB_NULL is not black");
+        }
+        if (depth - 1 > *height) {
+            *height = depth - 1;
+        }
+        return 1;
+    }
+    if (node->color != RB_BLACK && node->color != RB_RED) {
+        TS_FAIL(*failures, "\"%s\" has color %d", node->word, node->color);
+    }
+    if (node->parent != parent) {
+        TS_FAIL(*failures, "\"%s\" does not point back to its parent", node->word);
+    }
+    if (node->color == RB_RED
+        && (node->left->color != RB_BLACK || node->right->color != RB_BLACK)) {
+        TS_FAIL(*failures, "red \"%s\" has a red child", node->word);
+    }
+
+    int left = ts_check_node(node->left, node, depth + 1, prev, size, height, failures);
+    if (*prev != NULL && strcmp(*prev, node->word) >= 0) {
+        TS_FAIL(*failures, "\"%s\" is not after \"%s\"", node->word, *prev);
+    }
+    *prev = node->word;
+    (*size)++;
+    int right = ts_check_node(node->right, node, depth + 1, prev, size, height, failures);
+
+    if (left != right) {
+        TS_FAIL(*failures, "\"%s\" has black heights %d and %d", node->word, left, right);
+    }
+    return left + (node->color == RB_BLACK);
+}
+
+int
+ts_check_tree(const struct rb_node *tree, long size) {
+    const char *prev = NULL;
+    long found = 0;
+    int height = 0;
+    int failures = 0;
+
+    if (tree->word == NULL) { // empty
+        if (size != 0) {
+            TS_FAIL(failures, "tree is empty, expected %ld nodes", size);
+        }
+        return failures;
+    }
+    if (tree->color != RB_BLACK) {
+        TS_FAIL(failures, "root \"%s\" is not black", tree->word);
+    }
+    if (tree->parent->word != NULL) {
+        TS_FAIL(failures, "root \"%s\" has a parent", tree->word);
+    }
+    ts_check_node(tree, tree->parent, 1, &prev, &found, &height, &failures);
+    if (found != size) {
+        TS_FAIL(failures, "tree has %ld nodes, expected %ld", found, size);
+    }
+    if (height > ts_height_bound(found)) {
+        TS_FAIL(failures, "height %d exceeds 2 log2(n + 1) = %d for n = %ld",
+                height, ts_height_bound(found), found);
+    }
+    return failures;
+}
+
+static int
+ts_compare_words(const void *a, const void *b) {
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/* Reads the unique words of a file, sorted. Returns their number, or -1. */
+static long
+ts_load(const char *filename, char ***words) {
+    long n = wf_read(filename, words), unique = 0;
+    if (n < 0) {
+        return -1;
+    }
+
+    qsort(*words, n, sizeof(char *), ts_compare_words);
+    for (long i = 0; i < n; i++) {
+        if (unique > 0 && strcmp((*words)[unique - 1], (*words)[i]) == 0) {
+            free((*words)[i]);
+        } else {
+            (*words)[unique++] = (*words)[i];
+        }
+    }
+    return unique;
+}
+
+/* Arranges sorted words in the given order. */
+static void
+ts_order(char **sorted, char **order, long n, const char *kind) {
+    if (strcmp(kind, "sorted") == 0) {
+        memcpy(order, sorted, n * sizeof(char *));
+    } else if (strcmp(kind, "reverse") == 0) {
+        for (long i = 0; i < n; i++) {
+            order[i] = sorted[n - 1 - i];
+        }
+    } else if (strcmp(kind, "zig-zag") == 0) { // first, last, second, second to last, ...
+        for (long i = 0, lo = 0, hi = n - 1; i < n; i++) {
+            order[i] = i % 2 == 0 ? sorted[lo++] : sorted[hi--];
+        }
+    } else { // random, with a fixed seed so failures reproduce
+        unsigned long long state = 0x2545f4914f6cdd1dULL;
+        memcpy(order, sorted, n * sizeof(char *));
+        for (long i = n - 1; i > 0; i--) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            long j = (long) ((state >> 33) % (unsigned long long) (i + 1));
+            char *tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+    }
+}
+
+/*
+ * Tracks the key comparisons of each operation in a phase and
+ * fails the phase if one goes over the height bound.
+ * */
+struct ts_phase {
+    const char *name;
+    clock_t start;
+    unsigned long total;
+    unsigned long worst;
+    long ops;
+    int over;
+};
+
+static void
+ts_phase_begin(struct ts_phase *phase, const char *name) {
+    phase->name = name;
+    phase->start = clock();
+    phase->total = 0;
+    phase->worst = 0;
+    phase->ops = 0;
+    phase->over = 0;
+}
+
+static void
+ts_phase_op(struct ts_phase *phase, unsigned long before, long size) {
+    unsigned long compares = rb_compare_count - before;
+    phase->total += compares;
+    phase->ops++;
+    if (compares > phase->worst) {
+        phase->worst = compares;
+    }
+    if (compares > (unsigned long) ts_height_bound(size)) {
+        phase->over++;
+    }
+}
+
+static int
+ts_phase_end(struct ts_phase *phase, const struct rb_node *tree, long size) {
+    double ms = 1000.0 * (clock() - phase->start) / CLOCKS_PER_SEC;
+    int failures = 0;
+    printf("    %-8s %8ld ops %8.2f ms  compares/op avg %5.2f max %3lu\n",
+           phase->name, phase->ops, ms,
+           phase->ops > 0 ? (double) phase->total / phase->ops : 0.0, phase->worst);
+    if (phase->over > 0) {
+        TS_FAIL(failures, "%s: %d operations compared more keys than the height bound",
+                phase->name, phase->over);
+    }
+    return failures + ts_check_tree(tree, size);
+}
+
+static int
+ts_run_order(char **sorted, char **order, long n, const char *kind) {
+    struct rb_node *tree = malloc(sizeof(struct rb_node));
+    struct rb_node input = {NULL};
+    struct ts_phase phase;
+    long size = 0;
+    int failures = 0;
+    unsigned long before;
+
+    tree->word = NULL;
+    ts_order(sorted, order, n, kind);
+    printf("  %s\n", kind);
+
+    ts_phase_begin(&phase, "insert");
+    for (long i = 0; i < n; i++) {
+        input.word = order[i];
+        before = rb_compare_count;
+        struct rb_node *inserted = rb_insert(tree, &input);
+        if (inserted == NULL) {
+            TS_FAIL(failures, "insert of new \"%s\" reported a duplicate", order[i]);
+        } else if (strcmp(inserted->word, order[i]) != 0) {
+            TS_FAIL(failures, "insert of \"%s\" returned the node of \"%s\"",
+                    order[i], inserted->word);
+        }
+        ts_phase_op(&phase, before, ++size);
+    }
+    failures += ts_phase_end(&phase, tree, size);
+
+    ts_phase_begin(&phase, "repeat");
+    for (long i = 0; i < n; i++) {
+        input.word = order[i];
+        before = rb_compare_count;
+        if (rb_insert(tree, &input) != NULL) {
+            TS_FAIL(failures, "insert of duplicate \"%s\" added a node", order[i]);
+        }
+        ts_phase_op(&phase, before, size);
+    }
+    failures += ts_phase_end(&phase, tree, size);
+
+    ts_phase_begin(&phase, "find");
+    for (long i = 0; i < n; i++) {
+        input.word = order[i];
+        before = rb_compare_count;
+        struct rb_node *found = rb_find(tree, &input);
+        ts_phase_op(&phase, before, size);
+        if (found->word == NULL || strcmp(found->word, order[i]) != 0 || found->count != 2) {
+            TS_FAIL(failures, "find of \"%s\" failed", order[i]);
+        }
+    }
+    failures += ts_phase_end(&phase, tree, size);
+
+    ts_phase_begin(&phase, "delete");
+    for (long i = 0; i < n; i += 2) {
+        input.word = order[i];
+        before = rb_compare_count;
+        struct rb_node *deleted = rb_delete(tree, &input);
+        ts_phase_op(&phase, before, size);
+        if (deleted == NULL || strcmp(deleted->word, order[i]) != 0) {
+            TS_FAIL(failures, "delete of \"%s\" failed", order[i]);
+        } else {
+            size--;
+            free(deleted->word);
+            free(deleted);
+        }
+    }
+    failures += ts_phase_end(&phase, tree, size);
+    for (long i = 0; i < n; i++) {
+        input.word = order[i];
+        int present = rb_find(tree, &input)->word != NULL;
+        if (present != (i % 2 == 1)) {
+            TS_FAIL(failures, "\"%s\" is %s after deleting every other word",
+                    order[i], present ? "still present" : "missing");
+        }
+    }
+
+    ts_phase_begin(&phase, "drain");
+    for (long i = n - 1 - n % 2; i > 0; i -= 2) {
+        input.word = order[i];
+        before = rb_compare_count;
+        struct rb_node *deleted = rb_delete(tree, &input);
+        ts_phase_op(&phase, before, size);
+        if (deleted == NULL || strcmp(deleted->word, order[i]) != 0) {
+            TS_FAIL(failures, "delete of \"%s\" failed", order[i]);
+        } else {
+            size--;
+            free(deleted->word);
+            free(deleted);
+        }
+    }
+    failures += ts_phase_end(&phase, tree, size);
+    input.word = order[0];
+    if (n > 0 && rb_delete(tree, &input) != NULL) {
+        TS_FAIL(failures, "delete from an empty tree found \"%s\"", order[0]);
+    }
+
+    free(tree);
+    return failures;
+}
+
+int
+ts_run_corpus(const char *filename) {
+    static const char *kinds[] = {"sorted", "reverse", "zig-zag", "random"};
+    char **sorted;
+    int failures = 0;
+
+    long n = ts_load(filename, &sorted);
+    if (n < 0) {
+        printf("%s\n  FAIL: cannot open\n", filename);
+        return 1;
+    }
+    printf("%s: %ld unique words, height bound %d\n", filename, n, ts_height_bound(n));
+
+    char **order = malloc((n > 0 ? n : 1) * sizeof(char *));
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); k++) {
+        failures += ts_run_order(sorted, order, n, kinds[k]);
+    }
+    wf_free(sorted, n);
+    free(order);
+    return failures;
+}
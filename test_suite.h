@@ -1,7 +1,52 @@
+/**
+ * @file test_suite.h
+ * @brief Header file (API) for the RB tree invariant and balance tests.
+ */
+
 #ifndef TEST_SUITE_H
 #define TEST_SUITE_H
 
+#include "rb_node.h"
+
+/**
+ * @brief Largest height a balanced RB tree of @p size nodes may have.
+ *
+ * @param size Number of nodes in the tree.
+ * @return The largest h with h <= 2 log2(size + 1).
+ */
+int
+ts_height_bound(long size);
 
+/**
+ * @brief Verifies an RB tree.
+ *
+ * Checks the five red-black properties, that every child points
+ * back to its parent, that the keys are in strictly increasing
+ * order, that the tree holds @p size nodes and that its height is
+ * within ts_height_bound. Every violation is printed.
+ *
+ * @param tree The RB tree to verify.
+ * @param size The expected number of nodes.
+ * @return The number of violations found.
+ */
+int
+ts_check_tree(const struct rb_node *tree, long size);
 
+/**
+ * @brief Runs the insert/find/delete phases on one corpus.
+ *
+ * The unique words of @p filename are fed to a fresh tree in
+ * sorted, reverse-sorted, zig-zag and random order. Each order
+ * inserts every word twice, finds every word, deletes every other
+ * word and then deletes the rest. After each phase the tree is
+ * verified and the key comparisons of every single operation are
+ * held to ts_height_bound, so a tree that stops balancing fails
+ * even if it still gives the right answers.
+ *
+ * @param filename A file of whitespace-separated words.
+ * @return The number of failures.
+ */
+int
+ts_run_corpus(const char *filename);
 
 #endif //TEST_SUITE_H
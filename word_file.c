@@ -0,0 +1,38 @@
+/**
+ * @file word_file.c
+ * @brief Implementation file for reading a whole word file into memory.
+ */
+
+#include "word_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+long
+wf_read(const char *filename, char ***words) {
+    char buff[WF_MAX_WORD];
+    long n = 0, cap = 1024;
+    FILE *in = fopen(filename, "r");
+    if (in == NULL) {
+        return -1;
+    }
+    *words = malloc(cap * sizeof(char *));
+    while (fscanf(in, "%255s", buff) != EOF) { // width is WF_MAX_WORD - 1
+        if (n == cap) {
+            cap *= 2;
+            *words = realloc(*words, cap * sizeof(char *));
+        }
+        (*words)[n] = malloc(strlen(buff) + 1);
+        strcpy((*words)[n++], buff);
+    }
+    fclose(in);
+    return n;
+}
+
+void
+wf_free(char **words, long n) {
+    for (long i = 0; i < n; i++) {
+        free(words[i]);
+    }
+    free(words);
+}
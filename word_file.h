@@ -0,0 +1,39 @@
+/**
+ * @file word_file.h
+ * @brief Header file (API) for reading a whole word file into memory.
+ */
+
+#ifndef WORD_FILE_H
+#define WORD_FILE_H
+
+/**
+ * @brief Longest word read, including the terminating NUL.
+ *
+ * Longer tokens are split into pieces of at most WF_MAX_WORD - 1
+ * characters.
+ */
+#define WF_MAX_WORD 256
+
+/**
+ * @brief Reads all whitespace-separated words of a file.
+ *
+ * The words are returned in file order, each in its own allocation.
+ *
+ * @param filename Path of the file to read.
+ * @param words Set to the array of words.
+ * @return The number of words, or -1 if the file cannot be opened.
+ * @note The caller releases the words with wf_free.
+ */
+long
+wf_read(const char *filename, char ***words);
+
+/**
+ * @brief Frees an array of words returned by wf_read.
+ *
+ * @param words The words to free.
+ * @param n The number of words in @p words.
+ */
+void
+wf_free(char **words, long n);
+
+#endif //WORD_FILE_H